@@ -0,0 +1,12 @@
+int f() {
+    int n = 0;
+    while (n < 10) {
+        if (n == 5) {
+            return n;
+        } else {
+            n = n + 1;
+        }
+    }
+    if (0) { n = 1; }
+    return n;
+}
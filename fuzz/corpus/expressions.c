@@ -0,0 +1,4 @@
+int a = 2 * 3 + 4;
+float b = (1.5 - 0.5) / 2;
+int c = !(a >= 10) == -1;
+a = (a % 3) * (b + c);
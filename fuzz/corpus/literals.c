@@ -0,0 +1,8 @@
+int main() {
+    char c = '\n';
+    char q = '\'';
+    int a = 'a' + 1;
+    printf("tab\there \"quoted\" \x41\102 \\ done\n");
+    printf("%d\n", a);
+    return 0;
+}
@@ -0,0 +1,15 @@
+int main() {
+    int x = 10;
+    // This is a single-line comment
+    if (x > 5) {
+        printf("x is greater than 5\n");
+    }
+
+    /* This is a
+       multi-line comment */
+    for (int i = 0; i < 5; i = i + 1) {
+        x = x + i;
+    }
+
+    return 0;
+}
@@ -0,0 +1,311 @@
+// Differential test between the native parser (public/mini-compiler.cpp) and
+// the TypeScript parser (src/compiler/parser.ts).
+//
+//   g++ -std=c++17 -O2 public/mini-compiler.cpp -o mini-compiler
+//   npm install
+//   node fuzz/differential.mjs ./mini-compiler fuzz/corpus
+//   node fuzz/differential.mjs ./mini-compiler --random 1000 --seed 42
+//
+// Both parsers get the same inputs. Their ASTs are rendered in printAST's
+// format and compared line by line. An input that fails in both parsers
+// counts as agreement, even if the error messages differ. An input that
+// fails in only one parser is a divergence. An input that kills the native
+// server is reported as a crash, and the server is restarted for the rest.
+
+import { spawn } from 'node:child_process';
+import { mkdtempSync, readFileSync, readdirSync, rmSync, statSync, writeFileSync } from 'node:fs';
+import { createRequire } from 'node:module';
+import { tmpdir } from 'node:os';
+import { dirname, join, resolve } from 'node:path';
+import { performance } from 'node:perf_hooks';
+import { fileURLToPath } from 'node:url';
+
+const repoRoot = resolve(dirname(fileURLToPath(import.meta.url)), '..');
+const require = createRequire(import.meta.url);
+
+function usage() {
+  console.error('Usage: node fuzz/differential.mjs <mini-compiler> [--random <count>] [--seed <n>] [inputs...]');
+  process.exit(2);
+}
+
+// Transpiles the TS compiler to CommonJS in a scratch directory and loads it
+function loadTypeScriptParser() {
+  let ts;
+  try {
+    ts = require('typescript');
+  } catch {
+    console.error('Error: the "typescript" package is missing, run npm install first');
+    process.exit(1);
+  }
+
+  const outDir = mkdtempSync(join(tmpdir(), 'mini-compiler-diff-'));
+  for (const name of ['types', 'lexer', 'parser']) {
+    const source = readFileSync(join(repoRoot, 'src/compiler', `${name}.ts`), 'utf8');
+    const { outputText } = ts.transpileModule(source, {
+      compilerOptions: { module: ts.ModuleKind.CommonJS, target: ts.ScriptTarget.ES2020 }
+    });
+    writeFileSync(join(outDir, `${name}.js`), outputText);
+  }
+
+  const { Lexer } = require(join(outDir, 'lexer.js'));
+  const { Parser } = require(join(outDir, 'parser.js'));
+  rmSync(outDir, { recursive: true, force: true });
+  return { Lexer, Parser };
+}
+
+function renderAST(node, depth = 0, lines = []) {
+  lines.push(' '.repeat(depth * 2) + node.type + (node.value ? `: ${node.value}` : ''));
+  for (const child of node.children) {
+    renderAST(child, depth + 1, lines);
+  }
+  return lines;
+}
+
+// The TS parser logs and recovers from syntax errors, so any logged error counts as a failure
+function runTypeScript({ Lexer, Parser }, source) {
+  const logError = console.error;
+  let failed = false;
+  console.error = () => { failed = true; };
+
+  const start = performance.now();
+  try {
+    const tokens = new Lexer(source).tokenize();
+    const ast = new Parser(tokens).parse();
+    return { lines: failed ? null : renderAST(ast), ms: performance.now() - start };
+  } catch {
+    return { lines: null, ms: performance.now() - start };
+  } finally {
+    console.error = logError;
+  }
+}
+
+// One `mini-compiler --server` process. Requests go one at a time, so when the
+// server dies the input it was working on is known.
+class NativeServer {
+  constructor(binary) {
+    this.binary = binary;
+    this.process = null;
+  }
+
+  start() {
+    this.process = spawn(this.binary, ['--server'], { stdio: ['pipe', 'pipe', 'inherit'] });
+    this.buffer = Buffer.alloc(0);
+    this.pending = null;
+
+    // Events from a server that already died must not touch its replacement
+    const server = this.process;
+    server.stdin.on('error', () => {}); // a dead server surfaces through 'close'
+    server.stdout.on('data', (chunk) => {
+      if (this.process !== server) return;
+      this.buffer = Buffer.concat([this.buffer, chunk]);
+      this.deliver();
+    });
+    server.on('error', (error) => {
+      if (this.process === server) this.fail(null, error);
+    });
+    server.on('close', (code, signal) => {
+      if (this.process === server) this.fail(signal ? `killed by ${signal}` : `exited with status ${code}`);
+    });
+  }
+
+  deliver() {
+    if (!this.pending || this.buffer.length < 4) return;
+    const length = this.buffer.readUInt32BE(0);
+    if (this.buffer.length < 4 + length) return;
+
+    const payload = this.buffer.subarray(4, 4 + length).toString('utf8');
+    this.buffer = this.buffer.subarray(4 + length);
+
+    const header = 'OK\nAbstract Syntax Tree:\n';
+    const { resolve: resolveReply } = this.pending;
+    this.pending = null;
+    resolveReply({ lines: payload.startsWith(header) ? payload.slice(header.length).trimEnd().split('\n') : null });
+  }
+
+  // A crash is blamed on the pending input; a spawn error aborts the whole run
+  fail(reason, error = null) {
+    this.process = null;
+    if (this.pending) {
+      const { resolve: resolveReply, reject } = this.pending;
+      this.pending = null;
+      if (error) reject(new Error(`${this.binary}: ${error.message}`));
+      else resolveReply({ lines: null, crash: reason });
+    }
+  }
+
+  // Resolves to { lines } on a reply, or { lines: null, crash } if the server died on this input
+  request(source) {
+    if (!this.process) this.start();
+    return new Promise((resolveReply, reject) => {
+      this.pending = { resolve: resolveReply, reject };
+      const payload = Buffer.from(`ast\n${source}`, 'utf8');
+      const header = Buffer.alloc(4);
+      header.writeUInt32BE(payload.length);
+      this.process.stdin.write(Buffer.concat([header, payload]));
+    });
+  }
+
+  close() {
+    if (this.process) this.process.stdin.end();
+  }
+}
+
+// Runs every input through the native server, restarting it after a crash
+async function runNative(binary, sources) {
+  const server = new NativeServer(binary);
+  const results = [];
+  for (const source of sources) {
+    results.push(await server.request(source));
+  }
+  server.close();
+  return results;
+}
+
+function collectInputs(paths) {
+  const inputs = [];
+  for (const path of paths) {
+    if (statSync(path).isDirectory()) {
+      for (const entry of readdirSync(path).sort()) {
+        inputs.push(...collectInputs([join(path, entry)]));
+      }
+    } else {
+      inputs.push({ name: path, source: readFileSync(path, 'utf8') });
+    }
+  }
+  return inputs;
+}
+
+// Small deterministic PRNG so a failing --seed can be replayed
+function mulberry32(seed) {
+  return () => {
+    seed = (seed + 0x6d2b79f5) | 0;
+    let t = Math.imul(seed ^ (seed >>> 15), 1 | seed);
+    t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+}
+
+// Random programs built only from constructs both lexers understand
+function generateProgram(random) {
+  const pick = (items) => items[Math.floor(random() * items.length)];
+  const names = ['a', 'b', 'x', 'y'];
+
+  const expression = (depth) => {
+    if (depth > 3 || random() < 0.3) {
+      return random() < 0.5 ? pick(names) : String(Math.floor(random() * 100));
+    }
+    switch (Math.floor(random() * 4)) {
+      case 0: return `${expression(depth + 1)} ${pick(['+', '-', '*', '/', '%', '<', '<=', '>', '>=', '==', '!='])} ${expression(depth + 1)}`;
+      case 1: return `(${expression(depth + 1)})`;
+      case 2: return `${pick(['-', '!'])}${expression(depth + 1)}`;
+      default: return `${pick(names)} = ${expression(depth + 1)}`;
+    }
+  };
+
+  const statement = (depth) => {
+    switch (depth > 2 ? 0 : Math.floor(random() * 6)) {
+      case 0: return `${expression(0)};`;
+      case 1: return `int ${pick(names)} = ${expression(0)};`;
+      case 2: return `if (${expression(0)}) ${statement(depth + 1)}${random() < 0.5 ? ` else ${statement(depth + 1)}` : ''}`;
+      case 3: return `while (${expression(0)}) ${statement(depth + 1)}`;
+      case 4: return `{ ${statement(depth + 1)} ${statement(depth + 1)} }`;
+      default: return `// ${pick(names)}\n${statement(depth + 1)}`;
+    }
+  };
+
+  const body = Array.from({ length: 1 + Math.floor(random() * 5) }, () => statement(0)).join('\n  ');
+  return `int main() {\n  ${body}\n  return 0;\n}\n`;
+}
+
+function firstDifference(left, right) {
+  const length = Math.max(left.length, right.length);
+  for (let i = 0; i < length; i++) {
+    if (left[i] !== right[i]) return i;
+  }
+  return -1;
+}
+
+async function main() {
+  const args = process.argv.slice(2);
+  if (args.length < 1) usage();
+
+  const binary = resolve(args.shift());
+  const paths = [];
+  let randomCount = 0;
+  let seed = Date.now() % 100000;
+
+  while (args.length > 0) {
+    const arg = args.shift();
+    if (arg === '--random') {
+      randomCount = Number(args.shift());
+    } else if (arg === '--seed') {
+      seed = Number(args.shift());
+    } else if (arg.startsWith('--')) {
+      usage();
+    } else {
+      paths.push(arg);
+    }
+  }
+  if (!Number.isInteger(randomCount) || !Number.isInteger(seed)) usage();
+
+  const inputs = collectInputs(paths);
+  if (randomCount > 0) {
+    const random = mulberry32(seed);
+    for (let i = 0; i < randomCount; i++) {
+      inputs.push({ name: `random #${i} (seed ${seed})`, source: generateProgram(random) });
+    }
+  }
+  if (inputs.length === 0) usage();
+
+  const tsParser = loadTypeScriptParser();
+  const nativeResults = await runNative(binary, inputs.map((input) => input.source));
+
+  let divergences = 0;
+  const timings = [];
+
+  inputs.forEach((input, index) => {
+    const { lines: native, crash } = nativeResults[index];
+    const typescript = runTypeScript(tsParser, input.source);
+    timings.push({ name: input.name, bytes: Buffer.byteLength(input.source), ms: typescript.ms });
+
+    if (crash) {
+      divergences++;
+      console.log(`CRASH ${input.name}: the native server ${crash}`);
+      console.log(input.source);
+      return;
+    }
+
+    if (native === null && typescript.lines === null) return;
+
+    if (native === null || typescript.lines === null) {
+      divergences++;
+      console.log(`DIVERGENCE ${input.name}: only the ${native === null ? 'native' : 'TypeScript'} parser rejected it`);
+      console.log(input.source);
+      return;
+    }
+
+    const line = firstDifference(native, typescript.lines);
+    if (line >= 0) {
+      divergences++;
+      console.log(`DIVERGENCE ${input.name} at AST line ${line + 1}:`);
+      console.log(`  native:     ${native[line] ?? '<end>'}`);
+      console.log(`  typescript: ${typescript.lines[line] ?? '<end>'}`);
+      console.log(input.source);
+    }
+  });
+
+  // Inputs that cost the most per byte are where slow paths hide
+  timings.sort((a, b) => b.ms / Math.max(b.bytes, 1) - a.ms / Math.max(a.bytes, 1));
+  console.log('Slowest TypeScript parses per byte:');
+  for (const timing of timings.slice(0, 5)) {
+    console.log(`  ${timing.name}: ${timing.bytes} bytes, ${timing.ms.toFixed(3)} ms`);
+  }
+
+  console.log(`${inputs.length} inputs, ${divergences} divergences`);
+  process.exit(divergences === 0 ? 0 : 1);
+}
+
+main().catch((error) => {
+  console.error(`Error: ${error.message}`);
+  process.exit(1);
+});
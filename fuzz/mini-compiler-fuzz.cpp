@@ -0,0 +1,323 @@
+// Fuzz harness for the native lexer, parser and optimizer.
+//
+// libFuzzer build (clang):
+//   clang++ -std=c++17 -g -O1 -fsanitize=fuzzer,address,undefined -DMINI_COMPILER_LIBFUZZER
+//       fuzz/mini-compiler-fuzz.cpp -o mini-compiler-fuzz
+//   ./mini-compiler-fuzz fuzz/corpus
+//
+// Standalone build (any compiler):
+//   g++ -std=c++17 -O2 fuzz/mini-compiler-fuzz.cpp -o mini-compiler-fuzz
+//   ./mini-compiler-fuzz <input files...>   replay inputs and print per-input timings
+//   ./mini-compiler-fuzz --scaling          time pathological inputs at doubling sizes
+//   ./mini-compiler-fuzz --check            run known-answer checks for literal decoding
+//
+// Every input is timed. An input slower than MINI_COMPILER_FUZZ_SLOW_MS
+// (default 500) aborts, so libFuzzer keeps it as a crash reproducer.
+// Parse errors are expected and ignored. Any other exception is a bug and is
+// left to propagate.
+
+#define MINI_COMPILER_EMBEDDED
+#include "../public/mini-compiler.cpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+
+struct FuzzTiming {
+    double slowLimitMs;
+    double worstNsPerByte;
+};
+
+static FuzzTiming& fuzzTiming() {
+    static FuzzTiming timing = [] {
+        const char* limit = std::getenv("MINI_COMPILER_FUZZ_SLOW_MS");
+        return FuzzTiming{limit ? std::atof(limit) : 500.0, 0.0};
+    }();
+    return timing;
+}
+
+// Runs one source through every stage and returns the elapsed time in milliseconds
+static double runPipeline(const std::string& source) {
+    auto start = std::chrono::steady_clock::now();
+
+    try {
+        Lexer lexer(source);
+        auto tokens = lexer.tokenize();
+
+        // Decoding drops the quotes and folds escapes, so it can never grow the text
+        for (const auto& token : tokens) {
+            if ((token.type == "STRING" || token.type == "CHAR") &&
+                Lexer::unescape(token.value).size() + 2 > token.value.size()) {
+                std::fprintf(stderr, "unescape grew literal %s\n", token.value.c_str());
+                std::abort();
+            }
+        }
+
+        Parser parser(tokens);
+        auto ast = parser.parse();
+
+        Optimizer optimizer;
+        optimizer.optimize(ast);
+    } catch (const std::runtime_error&) {
+        // Lexical and syntax errors are the expected outcome for most inputs
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+// Times one input, reports new per-byte worst cases and aborts on slow inputs
+static double checkInput(const std::string& source) {
+    double elapsedMs = runPipeline(source);
+    size_t size = source.size();
+
+    FuzzTiming& timing = fuzzTiming();
+
+    // Per-byte cost only means something once inputs are past fixed overheads
+    if (size >= 64) {
+        double nsPerByte = elapsedMs * 1e6 / static_cast<double>(size);
+        if (nsPerByte > timing.worstNsPerByte) {
+            timing.worstNsPerByte = nsPerByte;
+            std::fprintf(stderr, "New slowest input: %zu bytes, %.3f ms, %.1f ns/byte\n",
+                         size, elapsedMs, nsPerByte);
+        }
+    }
+
+    if (elapsedMs > timing.slowLimitMs) {
+        std::fprintf(stderr, "Slow input: %zu bytes took %.3f ms (limit %.0f ms)\n",
+                     size, elapsedMs, timing.slowLimitMs);
+        std::abort();
+    }
+
+    return elapsedMs;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    checkInput(std::string(reinterpret_cast<const char*>(data), size));
+    return 0;
+}
+
+#ifndef MINI_COMPILER_LIBFUZZER
+struct ScalingCase {
+    const char* name;
+    std::function<std::string(size_t)> generate;
+    size_t minSize;
+    size_t maxSize;
+};
+
+static std::string repeat(const std::string& text, size_t count) {
+    std::string result;
+    result.reserve(text.size() * count);
+    for (size_t i = 0; i < count; i++) {
+        result += text;
+    }
+    return result;
+}
+
+// Least-squares slope of log(time) against log(size): ~1 is linear, ~2 quadratic
+static double growthExponent(const std::vector<std::pair<double, double>>& samples) {
+    double meanX = 0.0, meanY = 0.0;
+    for (const auto& sample : samples) {
+        meanX += std::log(sample.first);
+        meanY += std::log(sample.second);
+    }
+    meanX /= samples.size();
+    meanY /= samples.size();
+
+    double covariance = 0.0, variance = 0.0;
+    for (const auto& sample : samples) {
+        double dx = std::log(sample.first) - meanX;
+        covariance += dx * (std::log(sample.second) - meanY);
+        variance += dx * dx;
+    }
+    return covariance / variance;
+}
+
+// Per-run time of one source, repeating small inputs until a batch takes at
+// least minBatchMs so sub-millisecond timings are not dominated by noise
+static double timePipeline(const std::string& source, double minBatchMs) {
+    double best = 0.0;
+
+    // Best of three batches damps scheduler noise
+    for (int batch = 0; batch < 3; batch++) {
+        double totalMs = 0.0;
+        int runs = 0;
+        while (totalMs < minBatchMs) {
+            totalMs += runPipeline(source);
+            runs++;
+        }
+        double perRunMs = totalMs / runs;
+        best = batch == 0 ? perRunMs : std::min(best, perRunMs);
+    }
+    return best;
+}
+
+// Doubles each generator's size and fits how time grows over all steps, so a
+// single noisy step cannot flag a linear path. Nesting stays at 64 levels,
+// which the parser's stack limit accepts even in sanitizer builds.
+static int runScaling() {
+    const double MIN_BATCH_MS = 2.0;
+    const double MAX_LINEAR_EXPONENT = 1.5;
+
+    const std::vector<ScalingCase> cases = {
+        {"line comment", [](size_t n) { return "// " + std::string(n, 'x') + "\nint x;"; }, 1 << 12, 1 << 22},
+        {"block comments", [](size_t n) { return repeat("/* c */", n) + "int x;"; }, 1 << 10, 1 << 17},
+        {"string literal", [](size_t n) { return "int x = \"" + std::string(n, 's') + "\";"; }, 1 << 12, 1 << 22},
+        {"long expression", [](size_t n) { return "int x = 1" + repeat(" + y", n) + ";"; }, 1 << 10, 1 << 17},
+        {"statements", [](size_t n) { return "int f() {" + repeat(" x = x + 1;", n) + " }"; }, 1 << 8, 1 << 15},
+        {"nesting", [](size_t n) { return "int x = " + repeat("(", n) + "1" + repeat(")", n) + ";"; }, 1 << 2, 1 << 6},
+    };
+
+    int suspicious = 0;
+
+    for (const auto& scalingCase : cases) {
+        std::printf("%s:\n", scalingCase.name);
+        std::vector<std::pair<double, double>> samples;
+
+        for (size_t n = scalingCase.minSize; n <= scalingCase.maxSize; n *= 2) {
+            std::string source = scalingCase.generate(n);
+            double elapsedMs = timePipeline(source, MIN_BATCH_MS);
+
+            std::printf("  n=%-8zu %10zu bytes %10.3f ms\n", n, source.size(), elapsedMs);
+            samples.emplace_back(static_cast<double>(source.size()), elapsedMs);
+        }
+
+        double exponent = growthExponent(samples);
+        std::printf("  time grows as size^%.2f", exponent);
+        if (exponent > MAX_LINEAR_EXPONENT) {
+            std::printf("  <- superlinear");
+            suspicious++;
+        }
+        std::printf("\n");
+    }
+
+    return suspicious == 0 ? 0 : 1;
+}
+
+// Renders the optimized AST of a single declaration's initializer
+static std::string foldedInitializer(const std::string& source) {
+    Lexer lexer(source);
+    Parser parser(lexer.tokenize());
+    Optimizer optimizer;
+    auto ast = optimizer.optimize(parser.parse());
+
+    std::ostringstream out;
+    printAST(out, ast->children.at(0)->children.at(1)->children.at(0));
+    return out.str();
+}
+
+// Renders the whole optimized program followed by the optimizer's eliminated count
+static std::string optimizedProgram(const std::string& source) {
+    Lexer lexer(source);
+    Parser parser(lexer.tokenize());
+    Optimizer optimizer;
+    auto ast = optimizer.optimize(parser.parse());
+
+    std::ostringstream out;
+    printAST(out, ast);
+    out << "eliminated " << optimizer.eliminatedNodes() << "\n";
+    return out.str();
+}
+
+// Runs a source through the pipeline and returns its error message, or "OK"
+static std::string pipelineError(const std::string& source) {
+    try {
+        Lexer lexer(source);
+        Parser parser(lexer.tokenize());
+        Optimizer optimizer;
+        optimizer.optimize(parser.parse());
+        return "OK";
+    } catch (const std::runtime_error& e) {
+        return e.what();
+    }
+}
+
+static int runChecks() {
+    struct Check {
+        std::string actual;
+        std::string expected;
+    };
+
+    const std::vector<Check> checks = {
+        {Lexer::unescape("\"plain\""), "plain"},
+        {Lexer::unescape("\"a\\tb\\n\""), "a\tb\n"},
+        {Lexer::unescape("\"\\\"q\\\"\""), "\"q\""},
+        {Lexer::unescape("'\\''"), "'"},
+        {Lexer::unescape("\"\\x41\\102\\0\""), std::string("AB\0", 3)},
+        {Lexer::unescape("\"\\?\\\\\""), "?\\"},
+        {Lexer::unescape("'\\x1234567890abcdef'"), "\xef"},
+        {foldedInitializer("int a = 'a' + 1;"), "LITERAL: 98\n"},
+        {foldedInitializer("int a = '\\n' * 2;"), "LITERAL: 20\n"},
+        {foldedInitializer("int a = '\\x41' == 65;"), "LITERAL: 1\n"},
+        {foldedInitializer("int a = '\\x1234567890abcdef' + 1;"), "LITERAL: -16\n"},
+        {foldedInitializer("int a = 1.2.3 + 1;"), "BINARY: +\n  LITERAL: 1.2.3\n  LITERAL: 1\n"},
+        {foldedInitializer("double a = 1.0 / 3.0;"), "LITERAL: 0.3333333333333333\n"},
+        {foldedInitializer("double a = 0.1 + 0.2;"), "LITERAL: 0.30000000000000004\n"},
+        {foldedInitializer("double a = 2.5 * 2;"), "LITERAL: 5.0\n"},
+        {foldedInitializer("double a = -0.1;"), "LITERAL: -0.1\n"},
+        {foldedInitializer("int a = 2147483647 + 1;"), "BINARY: +\n  LITERAL: 2147483647\n  LITERAL: 1\n"},
+        {foldedInitializer("int a = 1 << 40;"), "BINARY: <<\n  LITERAL: 1\n  LITERAL: 40\n"},
+        {foldedInitializer("int a = 1 << 30;"), "LITERAL: 1073741824\n"},
+        {foldedInitializer("int a = -2147483647 - 1;"), "LITERAL: -2147483648\n"},
+        {foldedInitializer("int a = 3000000000 + 1;"), "LITERAL: 3000000001\n"},
+        {optimizedProgram("if (0) { x = 1; }"), "PROGRAM\neliminated 5\n"},
+        {optimizedProgram("if (1 - 1) {}"), "PROGRAM\neliminated 5\n"},
+        {optimizedProgram("if (1) x = 1; else y = 2;"), "PROGRAM\n  ASSIGNMENT: x\n    LITERAL: 1\neliminated 4\n"},
+        {optimizedProgram("if (0) x = 1; else y = 2;"), "PROGRAM\n  ASSIGNMENT: y\n    LITERAL: 2\neliminated 4\n"},
+        {optimizedProgram("if (x) while (0) y = 1;"),
+         "PROGRAM\n  IF_STATEMENT\n    IDENTIFIER: x\n    BLOCK\neliminated 3\n"},
+        {optimizedProgram("while (1) x = 1;"),
+         "PROGRAM\n  WHILE_STATEMENT\n    LITERAL: 1\n    ASSIGNMENT: x\n      LITERAL: 1\neliminated 0\n"},
+        {optimizedProgram("x = 0 ? y : z;"), "PROGRAM\n  ASSIGNMENT: x\n    IDENTIFIER: z\neliminated 3\n"},
+        {optimizedProgram("{ while (0) {} x; }"), "PROGRAM\n  BLOCK\n    IDENTIFIER: x\neliminated 3\n"},
+        {pipelineError(repeat("int f(){", 20000)), "Nesting too deep"},
+        {pipelineError("int x = " + repeat("(", 64) + "1" + repeat(")", 64) + ";"), "OK"},
+        {pipelineError("int x = 1" + repeat(" + y", 100000) + ";"), "OK"},
+        {pipelineError("int x = 1" + repeat(" + 1", 100000) + ";"), "OK"},
+    };
+
+    int failures = 0;
+    for (size_t i = 0; i < checks.size(); i++) {
+        if (checks[i].actual != checks[i].expected) {
+            std::fprintf(stderr, "Check %zu failed: got \"%s\", expected \"%s\"\n",
+                         i, checks[i].actual.c_str(), checks[i].expected.c_str());
+            failures++;
+        }
+    }
+
+    std::printf("%zu checks, %d failures\n", checks.size(), failures);
+    return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 2 && std::string(argv[1]) == "--scaling") {
+        return runScaling();
+    }
+    if (argc == 2 && std::string(argv[1]) == "--check") {
+        return runChecks();
+    }
+
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s --scaling | --check | <input files...>\n", argv[0]);
+        return 2;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        std::ifstream file(argv[i], std::ios::binary);
+        if (!file) {
+            std::fprintf(stderr, "Error: Cannot open %s\n", argv[i]);
+            return 1;
+        }
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        std::string source = contents.str();
+
+        double elapsedMs = checkInput(source);
+        std::printf("%s: %zu bytes, %.3f ms\n", argv[i], source.size(), elapsedMs);
+    }
+
+    return 0;
+}
+#endif // MINI_COMPILER_LIBFUZZER
@@ -5,6 +5,26 @@
 #include <unordered_map>
 #include <regex>
 #include <sstream>
+#include <map>
+#include <algorithm>
+#include <new>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <cstring>
+#include <stdexcept>
+#include <climits>
+#include <limits>
+#include <cmath>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <poll.h>
 
 struct Token {
     std::string type;
@@ -17,14 +37,167 @@ struct ASTNode {
     std::string type;
     std::string value;
     std::vector<std::shared_ptr<ASTNode>> children;
+
+    // A long operator chain is a very deep tree, so subtrees this node owns
+    // alone are released from a worklist instead of recursively
+    ~ASTNode() {
+        std::vector<std::shared_ptr<ASTNode>> pending;
+        pending.swap(children);
+
+        while (!pending.empty()) {
+            std::shared_ptr<ASTNode> node = std::move(pending.back());
+            pending.pop_back();
+            if (node.use_count() != 1 || node->children.empty()) continue;
+
+            try {
+                pending.reserve(pending.size() + node->children.size());
+            } catch (const std::bad_alloc&) {
+                continue; // Out of memory: this subtree is released recursively
+            }
+            for (auto& child : node->children) {
+                pending.push_back(std::move(child));
+            }
+            node->children.clear();
+        }
+    }
+};
+
+// Memory accounting. The global allocation functions below tag every heap
+// block with the stage that requested it, so live and peak bytes can be
+// reported per stage and an optional budget can be enforced.
+enum MemoryStage {
+    STAGE_DRIVER,
+    STAGE_LEXER,
+    STAGE_PARSER,
+    STAGE_OPTIMIZER,
+    STAGE_OUTPUT,
+    STAGE_COUNT
+};
+
+struct MemoryStats {
+    size_t live;
+    size_t peak;
+};
+
+struct MemoryAccounting {
+    MemoryStats stages[STAGE_COUNT];
+    MemoryStats total;
+    size_t budget;      // 0 means unlimited
+    int stage;
+    int failedStage;
+};
+
+// Zero-initialized before any dynamic initialization can allocate
+static MemoryAccounting memoryAccounting;
+
+// Starts a new measurement window: peaks fall back to what is live right now
+static void resetMemoryPeaks() {
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        memoryAccounting.stages[stage].peak = memoryAccounting.stages[stage].live;
+    }
+    memoryAccounting.total.peak = memoryAccounting.total.live;
+}
+
+static const char* const memoryStageNames[STAGE_COUNT] = {
+    "driver", "lexer", "parser", "optimizer", "output"
+};
+
+class MemoryBudgetExceeded : public std::bad_alloc {
+public:
+    const char* what() const noexcept override {
+        return "Memory budget exceeded";
+    }
+};
+
+// Makes every allocation in its lifetime count against the given stage
+class MemoryStageScope {
+private:
+    int previous;
+
+public:
+    explicit MemoryStageScope(MemoryStage stage) : previous(memoryAccounting.stage) {
+        memoryAccounting.stage = stage;
+    }
+
+    ~MemoryStageScope() {
+        memoryAccounting.stage = previous;
+    }
+};
+
+// Define MINI_COMPILER_EMBEDDED to include this file in another program (such as
+// the fuzz harness) without its main() or the global allocation hooks
+#ifndef MINI_COMPILER_EMBEDDED
+struct AllocationHeader {
+    size_t size;
+    int stage;
 };
 
+static const size_t ALLOCATION_HEADER_SIZE =
+    (sizeof(AllocationHeader) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+static void* trackedAllocate(size_t size) noexcept {
+    MemoryAccounting& acct = memoryAccounting;
+    if (acct.budget != 0 && acct.total.live + size > acct.budget) {
+        acct.failedStage = acct.stage;
+        return nullptr;
+    }
+
+    void* block = std::malloc(ALLOCATION_HEADER_SIZE + size);
+    if (!block) return nullptr;
+
+    AllocationHeader* header = static_cast<AllocationHeader*>(block);
+    header->size = size;
+    header->stage = acct.stage;
+
+    MemoryStats& stage = acct.stages[acct.stage];
+    stage.live += size;
+    if (stage.live > stage.peak) stage.peak = stage.live;
+    acct.total.live += size;
+    if (acct.total.live > acct.total.peak) acct.total.peak = acct.total.live;
+
+    return static_cast<char*>(block) + ALLOCATION_HEADER_SIZE;
+}
+
+static void trackedFree(void* pointer) noexcept {
+    if (!pointer) return;
+
+    void* block = static_cast<char*>(pointer) - ALLOCATION_HEADER_SIZE;
+    const AllocationHeader* header = static_cast<const AllocationHeader*>(block);
+    memoryAccounting.stages[header->stage].live -= header->size;
+    memoryAccounting.total.live -= header->size;
+    std::free(block);
+}
+
+static void* trackedAllocateOrThrow(size_t size) {
+    void* pointer = trackedAllocate(size);
+    if (!pointer) {
+        if (memoryAccounting.budget != 0 && memoryAccounting.total.live + size > memoryAccounting.budget) {
+            throw MemoryBudgetExceeded();
+        }
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new(size_t size) { return trackedAllocateOrThrow(size); }
+void* operator new[](size_t size) { return trackedAllocateOrThrow(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size); }
+void operator delete(void* pointer) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+#endif // MINI_COMPILER_EMBEDDED
+
 class Lexer {
 private:
     std::string input;
     size_t position;
     int line;
     int column;
+    bool keepComments;
 
     struct Pattern {
         std::string type;
@@ -35,13 +208,18 @@ private:
         {"KEYWORD", "int|char|float|double|void|if|else|while|for|return|printf"},
         {"IDENTIFIER", "[a-zA-Z_][a-zA-Z0-9_]*"},
         {"NUMBER", "\\d+(\\.\\d+)?"},
-        {"OPERATOR", "[+\\-*/%=<>!]"},
+        {"STRING", "\"([^\"\\\\\\n]|\\\\.)*\""},
+        {"CHAR", "'([^'\\\\\\n]|\\\\.)+'"},
+        {"OPERATOR", "<<=|>>=|->|\\+\\+|--|&&|\\|\\||[=!<>+\\-*/%&|^]=|<<|>>|[+\\-*/%=<>!&|^~?:.]"},
         {"PUNCTUATION", "[;,(){}\\[\\]]"},
         {"WHITESPACE", "[ \\t\\n\\r]+"}
     };
 
 public:
-    Lexer(const std::string& source) : input(source), position(0), line(1), column(1) {}
+    // Comments are never parsed, so low-memory callers can ask for them to be dropped.
+    // The source is taken by value so callers can move it in instead of copying it.
+    Lexer(std::string source, bool keepComments = true)
+        : input(std::move(source)), position(0), line(1), column(1), keepComments(keepComments) {}
 
     std::vector<Token> tokenize() {
         std::vector<Token> tokens;
@@ -66,30 +244,30 @@ public:
                 // Single-line comment
                 if (input[position + 1] == '/') {
                     int start_column = column;
-                    std::string comment = "//";
+                    size_t start = position;
                     position += 2;
                     column += 2;
                     
                     while (position < input.length() && input[position] != '\n') {
-                        comment += input[position];
                         position++;
                         column++;
                     }
                     
-                    tokens.push_back({"COMMENT", comment, line, start_column});
+                    if (keepComments) {
+                        tokens.push_back({"COMMENT", input.substr(start, position - start), line, start_column});
+                    }
                     continue;
                 }
                 // Multi-line comment
                 else if (input[position + 1] == '*') {
                     int start_column = column;
-                    std::string comment = "/*";
+                    size_t start = position;
                     position += 2;
                     column += 2;
                     
                     bool commentClosed = false;
                     while (position + 1 < input.length()) {
                         if (input[position] == '*' && input[position + 1] == '/') {
-                            comment += "*/";
                             position += 2;
                             column += 2;
                             commentClosed = true;
@@ -97,38 +275,44 @@ public:
                         }
                         
                         if (input[position] == '\n') {
-                            comment += input[position];
-                            position++;
                             line++;
                             column = 1;
                         } else {
-                            comment += input[position];
-                            position++;
                             column++;
                         }
+                        position++;
                     }
                     
                     if (!commentClosed) {
                         throw std::runtime_error("Unclosed multi-line comment");
                     }
                     
-                    tokens.push_back({"COMMENT", comment, line, start_column});
+                    if (keepComments) {
+                        tokens.push_back({"COMMENT", input.substr(start, position - start), line, start_column});
+                    }
                     continue;
                 }
             }
 
+            // Handle string and character literals, keeping the raw quoted text
+            if (current == '"' || current == '\'') {
+                tokens.push_back(quotedLiteral(current));
+                continue;
+            }
+
             // Handle identifiers and keywords
             if (isalpha(current) || current == '_') {
-                std::string identifier;
                 int start_column = column;
+                size_t start = position;
                 
                 while (position < input.length() && 
                        (isalnum(input[position]) || input[position] == '_')) {
-                    identifier += input[position];
                     position++;
                     column++;
                 }
 
+                std::string identifier = input.substr(start, position - start);
+
                 // Check if it's a keyword
                 if (isKeyword(identifier)) {
                     tokens.push_back({"KEYWORD", identifier, line, start_column});
@@ -140,45 +324,25 @@ public:
 
             // Handle numbers
             if (isdigit(current)) {
-                std::string number;
                 int start_column = column;
+                size_t start = position;
                 
                 while (position < input.length() && 
                        (isdigit(input[position]) || input[position] == '.')) {
-                    number += input[position];
                     position++;
                     column++;
                 }
                 
-                tokens.push_back({"NUMBER", number, line, start_column});
+                tokens.push_back({"NUMBER", input.substr(start, position - start), line, start_column});
                 continue;
             }
 
-            // Handle operators
-            if (strchr("+-*/%=<>!", current)) {
-                std::string op;
-                int start_column = column;
-                
-                op += current;
-                position++;
-                column++;
-                
-                // Handle two-character operators
-                if (position < input.length()) {
-                    char next = input[position];
-                    if ((current == '=' && next == '=') ||
-                        (current == '!' && next == '=') ||
-                        (current == '<' && next == '=') ||
-                        (current == '>' && next == '=') ||
-                        (current == '+' && next == '+') ||
-                        (current == '-' && next == '-')) {
-                        op += next;
-                        position++;
-                        column++;
-                    }
-                }
-                
-                tokens.push_back({"OPERATOR", op, line, start_column});
+            // Handle operators, longest match first
+            if (strchr("+-*/%=<>!&|^~?:.", current)) {
+                size_t length = operatorLength();
+                tokens.push_back({"OPERATOR", input.substr(position, length), line, column});
+                position += length;
+                column += static_cast<int>(length);
                 continue;
             }
 
@@ -200,7 +364,120 @@ public:
         return tokens;
     }
 
+    // Decodes the escape sequences of a raw STRING or CHAR token value on demand
+    static std::string unescape(const std::string& raw) {
+        std::string result;
+        if (raw.size() < 2) return result;
+
+        size_t end = raw.size() - 1;
+        result.reserve(end - 1);
+
+        for (size_t i = 1; i < end; i++) {
+            if (raw[i] != '\\' || i + 1 >= end) {
+                result += raw[i];
+                continue;
+            }
+
+            char escape = raw[++i];
+            switch (escape) {
+                case 'n': result += '\n'; break;
+                case 't': result += '\t'; break;
+                case 'r': result += '\r'; break;
+                case 'a': result += '\a'; break;
+                case 'b': result += '\b'; break;
+                case 'f': result += '\f'; break;
+                case 'v': result += '\v'; break;
+                case '\n': break; // Line continuation
+                case 'x': {
+                    // Every hex digit belongs to the escape, but only the low byte is
+                    // kept (as GCC does), so long escapes cannot overflow the value
+                    unsigned value = 0;
+                    while (i + 1 < end && isxdigit(static_cast<unsigned char>(raw[i + 1]))) {
+                        char digit = raw[++i];
+                        unsigned nibble = isdigit(digit) ? digit - '0' : tolower(digit) - 'a' + 10;
+                        value = ((value << 4) | nibble) & 0xFFu;
+                    }
+                    result += static_cast<char>(value);
+                    break;
+                }
+                default:
+                    if (escape >= '0' && escape <= '7') {
+                        int value = escape - '0';
+                        for (int digits = 1; digits < 3 && i + 1 < end && raw[i + 1] >= '0' && raw[i + 1] <= '7'; digits++) {
+                            value = value * 8 + (raw[++i] - '0');
+                        }
+                        result += static_cast<char>(value);
+                    } else {
+                        // \\, \', \", \? and unknown escapes stand for the character itself
+                        result += escape;
+                    }
+                    break;
+            }
+        }
+
+        return result;
+    }
+
 private:
+    Token quotedLiteral(char quote) {
+        int start_line = line;
+        int start_column = column;
+        size_t start = position;
+        const char* kind = quote == '"' ? "string" : "character";
+
+        position++;
+        column++;
+
+        while (position < input.length() && input[position] != quote) {
+            if (input[position] == '\n') {
+                break;
+            }
+            if (input[position] == '\\' && position + 1 < input.length()) {
+                position++;
+                column++;
+                if (input[position] == '\n') {
+                    line++;
+                    column = 0;
+                }
+            }
+            position++;
+            column++;
+        }
+
+        if (position >= input.length() || input[position] != quote) {
+            std::stringstream error;
+            error << "Unterminated " << kind << " literal at line " << start_line << ", column " << start_column;
+            throw std::runtime_error(error.str());
+        }
+
+        position++;
+        column++;
+
+        if (quote == '\'' && position - start == 2) {
+            std::stringstream error;
+            error << "Empty character literal at line " << start_line << ", column " << start_column;
+            throw std::runtime_error(error.str());
+        }
+
+        return {quote == '"' ? "STRING" : "CHAR", input.substr(start, position - start), start_line, start_column};
+    }
+
+    size_t operatorLength() const {
+        static const char* const multiCharOperators[] = {
+            "<<=", ">>=",
+            "==", "!=", "<=", ">=", "++", "--", "&&", "||", "->", "<<", ">>",
+            "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^="
+        };
+
+        for (const char* op : multiCharOperators) {
+            size_t length = strlen(op);
+            if (input.compare(position, length, op) == 0) {
+                return length;
+            }
+        }
+        return 1;
+    }
+
     bool isKeyword(const std::string& word) {
         static const std::unordered_map<std::string, bool> keywords = {
             {"int", true}, {"char", true}, {"float", true},
@@ -215,13 +492,22 @@ private:
 // Parser class for building AST
 class Parser {
 private:
+    // Recursion is limited by the stack it actually uses, not by a level
+    // count, because frames are several times larger in sanitizer builds.
+    // This leaves most of the default 8 MiB main-thread stack unused.
+    static const size_t MAX_STACK_BYTES = 2u * 1024u * 1024u;
+
     std::vector<Token> tokens;
     size_t current;
+    const char* stackBase;
 
 public:
-    Parser(const std::vector<Token>& tokens) : tokens(tokens), current(0) {}
+    Parser(const std::vector<Token>& tokens) : tokens(tokens), current(0), stackBase(nullptr) {}
+    Parser(std::vector<Token>&& tokens) : tokens(std::move(tokens)), current(0), stackBase(nullptr) {}
 
     std::shared_ptr<ASTNode> parse() {
+        stackBase = static_cast<const char*>(__builtin_frame_address(0));
+
         auto root = std::make_shared<ASTNode>();
         root->type = "PROGRAM";
 
@@ -241,6 +527,15 @@ public:
     }
 
 private:
+    // Called on entry to every parse function that can recurse
+    void checkNesting() const {
+        const char* frame = static_cast<const char*>(__builtin_frame_address(0));
+        size_t used = stackBase > frame ? stackBase - frame : frame - stackBase;
+        if (used > MAX_STACK_BYTES) {
+            throw std::runtime_error("Nesting too deep");
+        }
+    }
+
     Token peek() const {
         if (current >= tokens.size()) {
             return {"EOF", "", tokens.back().line, tokens.back().column};
@@ -293,6 +588,9 @@ private:
     }
 
     std::shared_ptr<ASTNode> parseDeclaration() {
+        // Blocks recurse back here, so nested function bodies are checked too
+        checkNesting();
+
         // Skip comments
         while (match("COMMENT")) {
             // Just skip them
@@ -385,12 +683,16 @@ private:
     }
 
     std::shared_ptr<ASTNode> parseStatement() {
+        checkNesting();
+
         // Skip comments
         while (match("COMMENT")) {
             // Just skip them
         }
         
-        if (isAtEnd()) return nullptr;
+        if (isAtEnd()) {
+            throw std::runtime_error("Expected statement at end of input");
+        }
         
         if (match("KEYWORD", "if")) {
             return parseIfStatement();
@@ -554,20 +856,149 @@ private:
     }
 
     std::shared_ptr<ASTNode> parseAssignment() {
-        auto expr = parseEquality();
+        checkNesting();
+
+        auto expr = parseConditional();
         
-        if (match("OPERATOR", "=")) {
+        if (match("OPERATOR", "=") || match("OPERATOR", "+=") || match("OPERATOR", "-=") ||
+            match("OPERATOR", "*=") || match("OPERATOR", "/=") || match("OPERATOR", "%=") ||
+            match("OPERATOR", "&=") || match("OPERATOR", "|=") || match("OPERATOR", "^=") ||
+            match("OPERATOR", "<<=") || match("OPERATOR", ">>=")) {
+            std::string op = previous().value;
             auto value = parseAssignment();
             
+            if (expr->type != "IDENTIFIER" && expr->type != "MEMBER_ACCESS") {
+                throw std::runtime_error("Invalid assignment target");
+            }
+
+            // Compound assignment x op= y is represented as x = x op y
+            if (op != "=") {
+                auto binaryNode = std::make_shared<ASTNode>();
+                binaryNode->type = "BINARY";
+                binaryNode->value = op.substr(0, op.size() - 1);
+                binaryNode->children.push_back(cloneTree(expr));
+                binaryNode->children.push_back(value);
+                value = binaryNode;
+            }
+
+            auto assignNode = std::make_shared<ASTNode>();
+            assignNode->type = "ASSIGNMENT";
             if (expr->type == "IDENTIFIER") {
-                auto assignNode = std::make_shared<ASTNode>();
-                assignNode->type = "ASSIGNMENT";
                 assignNode->value = expr->value;
-                assignNode->children.push_back(value);
-                return assignNode;
+            } else {
+                // Member targets have no single name, so the target is the first child
+                assignNode->children.push_back(expr);
             }
+            assignNode->children.push_back(value);
+            return assignNode;
+        }
+        
+        return expr;
+    }
+
+    std::shared_ptr<ASTNode> parseConditional() {
+        auto expr = parseLogicalOr();
+        
+        if (match("OPERATOR", "?")) {
+            checkNesting();
+
+            auto conditionalNode = std::make_shared<ASTNode>();
+            conditionalNode->type = "CONDITIONAL";
+            conditionalNode->children.push_back(expr);
+            conditionalNode->children.push_back(parseExpression());
+            consume("OPERATOR", ":", "Expected ':' in conditional expression");
+            conditionalNode->children.push_back(parseConditional());
+            return conditionalNode;
+        }
+        
+        return expr;
+    }
+
+    std::shared_ptr<ASTNode> parseLogicalOr() {
+        auto expr = parseLogicalAnd();
+        
+        while (match("OPERATOR", "||")) {
+            std::string op = previous().value;
+            auto right = parseLogicalAnd();
+            
+            auto binaryNode = std::make_shared<ASTNode>();
+            binaryNode->type = "BINARY";
+            binaryNode->value = op;
+            binaryNode->children.push_back(expr);
+            binaryNode->children.push_back(right);
+            expr = binaryNode;
+        }
+        
+        return expr;
+    }
+
+    std::shared_ptr<ASTNode> parseLogicalAnd() {
+        auto expr = parseBitwiseOr();
+        
+        while (match("OPERATOR", "&&")) {
+            std::string op = previous().value;
+            auto right = parseBitwiseOr();
+            
+            auto binaryNode = std::make_shared<ASTNode>();
+            binaryNode->type = "BINARY";
+            binaryNode->value = op;
+            binaryNode->children.push_back(expr);
+            binaryNode->children.push_back(right);
+            expr = binaryNode;
+        }
+        
+        return expr;
+    }
+
+    std::shared_ptr<ASTNode> parseBitwiseOr() {
+        auto expr = parseBitwiseXor();
+        
+        while (match("OPERATOR", "|")) {
+            std::string op = previous().value;
+            auto right = parseBitwiseXor();
+            
+            auto binaryNode = std::make_shared<ASTNode>();
+            binaryNode->type = "BINARY";
+            binaryNode->value = op;
+            binaryNode->children.push_back(expr);
+            binaryNode->children.push_back(right);
+            expr = binaryNode;
+        }
+        
+        return expr;
+    }
+
+    std::shared_ptr<ASTNode> parseBitwiseXor() {
+        auto expr = parseBitwiseAnd();
+        
+        while (match("OPERATOR", "^")) {
+            std::string op = previous().value;
+            auto right = parseBitwiseAnd();
+            
+            auto binaryNode = std::make_shared<ASTNode>();
+            binaryNode->type = "BINARY";
+            binaryNode->value = op;
+            binaryNode->children.push_back(expr);
+            binaryNode->children.push_back(right);
+            expr = binaryNode;
+        }
+        
+        return expr;
+    }
+
+    std::shared_ptr<ASTNode> parseBitwiseAnd() {
+        auto expr = parseEquality();
+        
+        while (match("OPERATOR", "&")) {
+            std::string op = previous().value;
+            auto right = parseEquality();
             
-            throw std::runtime_error("Invalid assignment target");
+            auto binaryNode = std::make_shared<ASTNode>();
+            binaryNode->type = "BINARY";
+            binaryNode->value = op;
+            binaryNode->children.push_back(expr);
+            binaryNode->children.push_back(right);
+            expr = binaryNode;
         }
         
         return expr;
@@ -592,11 +1023,29 @@ private:
     }
 
     std::shared_ptr<ASTNode> parseComparison() {
-        auto expr = parseTerm();
+        auto expr = parseShift();
         
         while (match("OPERATOR", ">") || match("OPERATOR", ">=") || 
                match("OPERATOR", "<") || match("OPERATOR", "<=")) {
             std::string op = previous().value;
+            auto right = parseShift();
+            
+            auto binaryNode = std::make_shared<ASTNode>();
+            binaryNode->type = "BINARY";
+            binaryNode->value = op;
+            binaryNode->children.push_back(expr);
+            binaryNode->children.push_back(right);
+            expr = binaryNode;
+        }
+        
+        return expr;
+    }
+
+    std::shared_ptr<ASTNode> parseShift() {
+        auto expr = parseTerm();
+        
+        while (match("OPERATOR", "<<") || match("OPERATOR", ">>")) {
+            std::string op = previous().value;
             auto right = parseTerm();
             
             auto binaryNode = std::make_shared<ASTNode>();
@@ -647,7 +1096,9 @@ private:
     }
 
     std::shared_ptr<ASTNode> parseUnary() {
-        if (match("OPERATOR", "!") || match("OPERATOR", "-")) {
+        checkNesting();
+
+        if (match("OPERATOR", "!") || match("OPERATOR", "-") || match("OPERATOR", "~")) {
             std::string op = previous().value;
             auto right = parseUnary();
             
@@ -658,10 +1109,34 @@ private:
             return unaryNode;
         }
         
-        return parsePrimary();
+        return parsePostfix();
+    }
+
+    std::shared_ptr<ASTNode> parsePostfix() {
+        auto expr = parsePrimary();
+        
+        while (match("OPERATOR", ".") || match("OPERATOR", "->")) {
+            std::string op = previous().value;
+            Token member = consume("IDENTIFIER", "", "Expected member name after '" + op + "'");
+            
+            auto memberNode = std::make_shared<ASTNode>();
+            memberNode->type = "IDENTIFIER";
+            memberNode->value = member.value;
+            
+            auto accessNode = std::make_shared<ASTNode>();
+            accessNode->type = "MEMBER_ACCESS";
+            accessNode->value = op;
+            accessNode->children.push_back(expr);
+            accessNode->children.push_back(memberNode);
+            expr = accessNode;
+        }
+        
+        return expr;
     }
 
     std::shared_ptr<ASTNode> parsePrimary() {
+        checkNesting();
+
         if (match("NUMBER")) {
             auto literalNode = std::make_shared<ASTNode>();
             literalNode->type = "LITERAL";
@@ -669,10 +1144,24 @@ private:
             return literalNode;
         }
         
-        if (match("IDENTIFIER")) {
+        // String and character literals keep their raw quoted text
+        if (match("STRING") || match("CHAR")) {
+            auto literalNode = std::make_shared<ASTNode>();
+            literalNode->type = "LITERAL";
+            literalNode->value = previous().value;
+            return literalNode;
+        }
+        
+        if (match("IDENTIFIER") || match("KEYWORD", "printf")) {
+            std::string name = previous().value;
+
+            if (match("PUNCTUATION", "(")) {
+                return parseCall(name);
+            }
+
             auto idNode = std::make_shared<ASTNode>();
             idNode->type = "IDENTIFIER";
-            idNode->value = previous().value;
+            idNode->value = name;
             return idNode;
         }
         
@@ -688,26 +1177,1043 @@ private:
         
         throw std::runtime_error("Expected expression");
     }
-};
 
-// Function to pretty-print the AST
-void printAST(const std::shared_ptr<ASTNode>& node, int depth = 0) {
-    std::string indent(depth * 2, ' ');
-    
-    std::cout << indent << node->type;
-    if (!node->value.empty()) {
-        std::cout << ": " << node->value;
+    // Iterative for the same reason as ~ASTNode
+    static std::shared_ptr<ASTNode> cloneTree(const std::shared_ptr<ASTNode>& node) {
+        auto root = std::make_shared<ASTNode>();
+        std::vector<std::pair<const ASTNode*, ASTNode*>> pending{{node.get(), root.get()}};
+
+        while (!pending.empty()) {
+            const ASTNode* source = pending.back().first;
+            ASTNode* copy = pending.back().second;
+            pending.pop_back();
+
+            copy->type = source->type;
+            copy->value = source->value;
+            for (const auto& child : source->children) {
+                copy->children.push_back(std::make_shared<ASTNode>());
+                pending.emplace_back(child.get(), copy->children.back().get());
+            }
+        }
+        return root;
     }
-    std::cout << std::endl;
-    
-    for (const auto& child : node->children) {
-        printAST(child, depth + 1);
+
+    std::shared_ptr<ASTNode> parseCall(const std::string& name) {
+        auto callNode = std::make_shared<ASTNode>();
+        callNode->type = "CALL";
+        callNode->value = name;
+        
+        if (!check("PUNCTUATION", ")")) {
+            do {
+                callNode->children.push_back(parseExpression());
+            } while (match("PUNCTUATION", ","));
+        }
+        
+        consume("PUNCTUATION", ")", "Expected ')' after arguments");
+        
+        return callNode;
     }
-}
+};
 
-int main() {
-    // Example usage
-    std::string source = R"(
+// Optimizer pass: constant folding and dead-branch elimination over the AST
+class Optimizer {
+private:
+    size_t eliminated;
+
+public:
+    Optimizer() : eliminated(0) {}
+
+    // Rewrites the tree in place to avoid copying it, so root is consumed:
+    // callers must use the returned tree and not the one they passed in
+    std::shared_ptr<ASTNode> optimize(std::shared_ptr<ASTNode> root) {
+        eliminated = 0;
+        auto result = visit(root);
+        return result ? result : makeNode("PROGRAM");
+    }
+
+    size_t eliminatedNodes() const {
+        return eliminated;
+    }
+
+private:
+    static std::shared_ptr<ASTNode> makeNode(const std::string& type, const std::string& value = "") {
+        auto node = std::make_shared<ASTNode>();
+        node->type = type;
+        node->value = value;
+        return node;
+    }
+
+    static size_t countNodes(const std::shared_ptr<ASTNode>& node) {
+        size_t count = 0;
+        std::vector<const ASTNode*> pending;
+        if (node) pending.push_back(node.get());
+
+        while (!pending.empty()) {
+            const ASTNode* current = pending.back();
+            pending.pop_back();
+            count++;
+            for (const auto& child : current->children) {
+                if (child) pending.push_back(child.get());
+            }
+        }
+        return count;
+    }
+
+    // A node whose children are being optimized, and the replacements collected so far
+    struct VisitFrame {
+        std::shared_ptr<ASTNode> node;
+        size_t next;
+        std::vector<std::shared_ptr<ASTNode>> children;
+    };
+
+    // Post-order walk that keeps its own stack, so tree depth is not bounded
+    // by the call stack. Returns the replacement for node, or nullptr if the statement can be dropped.
+    std::shared_ptr<ASTNode> visit(const std::shared_ptr<ASTNode>& node) {
+        if (!node) return nullptr;
+
+        std::vector<VisitFrame> stack;
+        stack.push_back({node, 0, {}});
+        std::shared_ptr<ASTNode> result;
+
+        while (!stack.empty()) {
+            VisitFrame& frame = stack.back();
+            if (frame.next < frame.node->children.size()) {
+                std::shared_ptr<ASTNode> child = frame.node->children[frame.next++];
+                if (child) {
+                    stack.push_back({child, 0, {}});
+                } else {
+                    adoptChild(frame, nullptr);
+                }
+                continue;
+            }
+
+            frame.node->children.swap(frame.children);
+            result = fold(frame.node);
+            stack.pop_back();
+            if (!stack.empty()) {
+                adoptChild(stack.back(), result);
+            }
+        }
+        return result;
+    }
+
+    void adoptChild(VisitFrame& parent, const std::shared_ptr<ASTNode>& optimized) {
+        if (optimized) {
+            parent.children.push_back(optimized);
+        } else if (parent.node->type != "PROGRAM" && parent.node->type != "BLOCK") {
+            // Statement slots such as an if/while body still need a node
+            parent.children.push_back(makeNode("BLOCK"));
+            eliminated--;
+        }
+    }
+
+    // Folds or prunes one node whose children are already optimized
+    std::shared_ptr<ASTNode> fold(const std::shared_ptr<ASTNode>& node) {
+        if (node->type == "GROUPING") {
+            return foldGrouping(node);
+        }
+        if (node->type == "UNARY") {
+            return foldUnary(node);
+        }
+        if (node->type == "BINARY") {
+            return foldBinary(node);
+        }
+        if (node->type == "IF_STATEMENT" || node->type == "CONDITIONAL") {
+            return pruneIf(node);
+        }
+        if (node->type == "WHILE_STATEMENT") {
+            return pruneWhile(node);
+        }
+        return node;
+    }
+
+    std::shared_ptr<ASTNode> foldGrouping(const std::shared_ptr<ASTNode>& node) {
+        // Precedence is already encoded in the tree shape, so the wrapper is redundant
+        if (node->children.size() != 1) return node;
+
+        eliminated++;
+        return node->children[0];
+    }
+
+    std::shared_ptr<ASTNode> foldUnary(const std::shared_ptr<ASTNode>& node) {
+        if (node->children.size() != 1 || !isLiteral(node->children[0])) return node;
+
+        const std::string& operand = node->children[0]->value;
+        std::string result;
+
+        if (node->value == "!") {
+            result = isTruthy(operand) ? "0" : "1";
+        } else if (node->value == "~") {
+            long long value;
+            if (!parseInteger(operand, value)) return node;
+            result = std::to_string(~value);
+        } else if (node->value == "-") {
+            if (isFloatLiteral(operand)) {
+                double value;
+                if (!parseFloat(operand, value)) return node;
+                result = formatFloat(-value);
+            } else {
+                long long value;
+                if (!parseInteger(operand, value) || value == LLONG_MIN) return node;
+                if (fitsInt(value) && !fitsInt(-value)) return node;
+                result = std::to_string(-value);
+            }
+        } else {
+            return node;
+        }
+
+        return replaceWithLiteral(node, result);
+    }
+
+    std::shared_ptr<ASTNode> foldBinary(const std::shared_ptr<ASTNode>& node) {
+        if (node->children.size() != 2 ||
+            !isLiteral(node->children[0]) || !isLiteral(node->children[1])) {
+            return node;
+        }
+
+        const std::string& op = node->value;
+        const std::string& left = node->children[0]->value;
+        const std::string& right = node->children[1]->value;
+        std::string result;
+
+        if (isFloatLiteral(left) || isFloatLiteral(right)) {
+            double a, b;
+            if (!parseFloat(left, a) || !parseFloat(right, b)) return node;
+            if (!foldFloat(op, a, b, result)) return node;
+        } else {
+            long long a, b;
+            if (!parseInteger(left, a) || !parseInteger(right, b)) return node;
+            if (!foldInteger(op, a, b, result)) return node;
+        }
+
+        return replaceWithLiteral(node, result);
+    }
+
+    // Also handles CONDITIONAL, whose two arms mean it never prunes to nothing
+    std::shared_ptr<ASTNode> pruneIf(const std::shared_ptr<ASTNode>& node) {
+        if (node->children.empty() || !isLiteral(node->children[0])) return node;
+
+        bool taken = isTruthy(node->children[0]->value);
+        std::shared_ptr<ASTNode> survivor;
+
+        if (taken && node->children.size() > 1) {
+            survivor = node->children[1];
+        } else if (!taken && node->children.size() > 2) {
+            survivor = node->children[2];
+        }
+
+        eliminated += countNodes(node) - countNodes(survivor);
+        return survivor;
+    }
+
+    std::shared_ptr<ASTNode> pruneWhile(const std::shared_ptr<ASTNode>& node) {
+        if (node->children.empty() || !isLiteral(node->children[0])) return node;
+        if (isTruthy(node->children[0]->value)) return node;
+
+        eliminated += countNodes(node);
+        return nullptr;
+    }
+
+    std::shared_ptr<ASTNode> replaceWithLiteral(const std::shared_ptr<ASTNode>& node, const std::string& value) {
+        eliminated += countNodes(node) - 1;
+        return makeNode("LITERAL", value);
+    }
+
+    static bool isLiteral(const std::shared_ptr<ASTNode>& node) {
+        // STRING literals are not folded
+        if (!node || node->type != "LITERAL" || node->value.empty()) return false;
+
+        // A single-character CHAR literal is an int constant
+        if (isCharLiteral(node->value)) {
+            long long value;
+            return parseInteger(node->value, value);
+        }
+
+        size_t first = node->value[0] == '-' ? 1 : 0;
+        if (first >= node->value.size() || !isdigit(static_cast<unsigned char>(node->value[first]))) return false;
+
+        // Malformed numbers such as 1.2.3 are left alone
+        double value;
+        return parseFloat(node->value, value);
+    }
+
+    static bool isCharLiteral(const std::string& value) {
+        return value[0] == '\'';
+    }
+
+    static bool isFloatLiteral(const std::string& value) {
+        return !isCharLiteral(value) && value.find_first_of(".eE") != std::string::npos;
+    }
+
+    static bool isTruthy(const std::string& value) {
+        double number;
+        return parseFloat(value, number) && number != 0.0;
+    }
+
+    // Unlike std::stod this never throws; partial and out-of-range parses fail
+    static bool parseFloat(const std::string& value, double& out) {
+        if (isCharLiteral(value)) {
+            long long character;
+            if (!parseInteger(value, character)) return false;
+            out = static_cast<double>(character);
+            return true;
+        }
+
+        char* end = nullptr;
+        out = std::strtod(value.c_str(), &end);
+        return end == value.c_str() + value.size() && std::isfinite(out);
+    }
+
+    static bool parseInteger(const std::string& value, long long& out) {
+        // Escapes are only decoded here, when a CHAR literal is actually folded
+        if (isCharLiteral(value)) {
+            std::string decoded = Lexer::unescape(value);
+            if (decoded.size() != 1) return false;
+            out = static_cast<signed char>(decoded[0]);
+            return true;
+        }
+
+        try {
+            size_t consumed = 0;
+            out = std::stoll(value, &consumed);
+            return consumed == value.size();
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    // Shortest spelling that reads back as the same double, so folding never
+    // changes a value: 0.1 + 0.2 is 0.30000000000000004, not 0.3
+    static std::string formatFloat(double value) {
+        std::string text;
+        for (int precision = std::numeric_limits<double>::digits10;
+             precision <= std::numeric_limits<double>::max_digits10; precision++) {
+            std::ostringstream out;
+            out.precision(precision);
+            out << value;
+            text = out.str();
+            if (std::strtod(text.c_str(), nullptr) == value) break;
+        }
+
+        if (text.find_first_of(".eE") == std::string::npos) {
+            text += ".0";
+        }
+        return text;
+    }
+
+    static bool fitsInt(long long value) {
+        return value >= INT_MIN && value <= INT_MAX;
+    }
+
+    // Unsuffixed literals that fit an int are int in C, so their results must
+    // fit one too; larger literals are long and use the 64-bit range
+    static bool foldInteger(const std::string& op, long long a, long long b, std::string& result) {
+        bool intOperands = fitsInt(a) && fitsInt(b);
+        int width = intOperands ? 31 : 63;
+        long long maximum = intOperands ? INT_MAX : LLONG_MAX;
+        long long value;
+
+        if (op == "+") {
+            if (__builtin_add_overflow(a, b, &value)) return false;
+        } else if (op == "-") {
+            if (__builtin_sub_overflow(a, b, &value)) return false;
+        } else if (op == "*") {
+            if (__builtin_mul_overflow(a, b, &value)) return false;
+        } else if (op == "/" || op == "%") {
+            // Leave runtime faults in place rather than folding them away
+            if (b == 0 || (a == LLONG_MIN && b == -1)) return false;
+            value = op == "/" ? a / b : a % b;
+        } else if (op == "<<") {
+            // Only shifts that C defines and that stay in range are folded
+            if (a < 0 || b < 0 || b >= width || a > (maximum >> b)) return false;
+            value = a << b;
+        } else if (op == ">>") {
+            if (a < 0 || b < 0 || b >= width) return false;
+            value = a >> b;
+        } else if (op == "&") {
+            value = a & b;
+        } else if (op == "|") {
+            value = a | b;
+        } else if (op == "^") {
+            value = a ^ b;
+        } else if (op == "&&") {
+            value = a && b;
+        } else if (op == "||") {
+            value = a || b;
+        } else if (op == "==") {
+            value = a == b;
+        } else if (op == "!=") {
+            value = a != b;
+        } else if (op == "<") {
+            value = a < b;
+        } else if (op == "<=") {
+            value = a <= b;
+        } else if (op == ">") {
+            value = a > b;
+        } else if (op == ">=") {
+            value = a >= b;
+        } else {
+            return false;
+        }
+
+        // Overflow of an int expression is undefined, so it is left to run time
+        if (intOperands && !fitsInt(value)) return false;
+
+        result = std::to_string(value);
+        return true;
+    }
+
+    static bool foldFloat(const std::string& op, double a, double b, std::string& result) {
+        if (op == "+" || op == "-" || op == "*" || op == "/") {
+            if (op == "/" && b == 0.0) return false;
+
+            double value = op == "+" ? a + b : op == "-" ? a - b : op == "*" ? a * b : a / b;
+            // Overflowed results have no literal spelling, so leave them to run time
+            if (!std::isfinite(value)) return false;
+            result = formatFloat(value);
+        } else if (op == "&&") {
+            result = a != 0.0 && b != 0.0 ? "1" : "0";
+        } else if (op == "||") {
+            result = a != 0.0 || b != 0.0 ? "1" : "0";
+        } else if (op == "==") {
+            result = a == b ? "1" : "0";
+        } else if (op == "!=") {
+            result = a != b ? "1" : "0";
+        } else if (op == "<") {
+            result = a < b ? "1" : "0";
+        } else if (op == "<=") {
+            result = a <= b ? "1" : "0";
+        } else if (op == ">") {
+            result = a > b ? "1" : "0";
+        } else if (op == ">=") {
+            result = a >= b ? "1" : "0";
+        } else {
+            return false;
+        }
+        return true;
+    }
+};
+
+// Function to pretty-print the AST
+void printAST(std::ostream& out, const std::shared_ptr<ASTNode>& node, int depth = 0) {
+    // Not recursive: a 100,000-term expression is a tree 100,000 levels deep
+    std::vector<std::pair<const ASTNode*, int>> pending{{node.get(), depth}};
+
+    while (!pending.empty()) {
+        const ASTNode* current = pending.back().first;
+        int level = pending.back().second;
+        pending.pop_back();
+
+        out << std::string(level * 2, ' ') << current->type;
+        if (!current->value.empty()) {
+            out << ": " << current->value;
+        }
+        out << "\n";
+
+        for (auto child = current->children.rbegin(); child != current->children.rend(); ++child) {
+            pending.emplace_back(child->get(), level + 1);
+        }
+    }
+}
+
+void printAST(const std::shared_ptr<ASTNode>& node, int depth = 0) {
+    printAST(std::cout, node, depth);
+}
+
+void printTokens(std::ostream& out, const std::vector<Token>& tokens) {
+    for (const auto& token : tokens) {
+        out << "Type: " << token.type 
+            << ", Value: " << token.value 
+            << ", Line: " << token.line 
+            << ", Column: " << token.column << "\n";
+    }
+}
+
+// Bytes a string owns on the heap, or 0 when it fits in the small-string buffer
+static size_t stringHeapBytes(const std::string& text) {
+    const char* data = text.data();
+    const char* object = reinterpret_cast<const char*>(&text);
+    if (data >= object && data < object + sizeof(text)) return 0;
+    return text.capacity() + 1;
+}
+
+// Bytes one make_shared<ASTNode>() allocation takes, control block included
+static size_t astNodeAllocationSize() {
+    static const size_t size = [] {
+        size_t before = memoryAccounting.total.live;
+        auto probe = std::make_shared<ASTNode>();
+        return memoryAccounting.total.live - before;
+    }();
+    return size;
+}
+
+// Nodes of one type in a finished tree and the heap bytes they retain
+struct NodeFootprint {
+    size_t nodes;
+    size_t bytes;
+};
+
+static void collectNodeFootprint(const std::shared_ptr<ASTNode>& node,
+                                 std::map<std::string, NodeFootprint>& byType) {
+    std::vector<const ASTNode*> pending{node.get()};
+
+    while (!pending.empty()) {
+        const ASTNode* current = pending.back();
+        pending.pop_back();
+
+        NodeFootprint& footprint = byType[current->type];
+        footprint.nodes++;
+        footprint.bytes += astNodeAllocationSize() + stringHeapBytes(current->type) +
+                           stringHeapBytes(current->value) +
+                           current->children.capacity() * sizeof(std::shared_ptr<ASTNode>);
+
+        for (const auto& child : current->children) {
+            pending.push_back(child.get());
+        }
+    }
+}
+
+void printMemoryReport(std::ostream& out, const std::shared_ptr<ASTNode>& ast) {
+    out << "Memory usage (bytes):\n";
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        out << "  " << memoryStageNames[stage]
+            << ": live " << memoryAccounting.stages[stage].live
+            << ", peak " << memoryAccounting.stages[stage].peak << "\n";
+    }
+    out << "  total: live " << memoryAccounting.total.live << ", peak " << memoryAccounting.total.peak;
+    if (memoryAccounting.budget != 0) {
+        out << ", budget " << memoryAccounting.budget;
+    }
+    out << "\n";
+
+    if (!ast) return;
+
+    std::map<std::string, NodeFootprint> byType;
+    collectNodeFootprint(ast, byType);
+
+    // Measured by walking the tree, so this is what the final AST retains, not a peak
+    out << "AST footprint by node type (final tree):\n";
+    for (const auto& entry : byType) {
+        out << "  " << entry.first << ": " << entry.second.nodes << " nodes, "
+            << entry.second.bytes << " bytes\n";
+    }
+}
+
+// Long-running server mode. Requests and responses are framed as a 4-byte
+// big-endian payload length followed by the payload. A request payload is a
+// header line naming the wanted outputs ("tokens", "ast", "optimized",
+// "memory"), followed by the source. A response payload starts with "OK\n" or
+// "ERROR <message>\n", followed by the rendered outputs.
+class CompilerServer {
+private:
+    static const uint32_t MAX_FRAME_SIZE = 64u * 1024u * 1024u;
+    static const size_t READ_CHUNK_SIZE = 64 * 1024;
+
+    // A client whose unsent replies pass this size is not read from until it catches up
+    static const size_t MAX_PENDING_OUTPUT = 4u * 1024u * 1024u;
+
+    struct Connection {
+        int fd;
+        std::string inbox;
+        std::string outbox;
+        bool closing;
+    };
+
+    // Buffers are kept across requests so a warm server does not reallocate them
+    std::string response;
+    std::vector<char> chunk;
+    bool reportMemory;
+
+public:
+    // With reportMemory set, a memory report goes to stderr whenever a client is done
+    explicit CompilerServer(bool reportMemory = false) : chunk(READ_CHUNK_SIZE), reportMemory(reportMemory) {}
+
+    // Serves frames from inFd until EOF, replying on outFd
+    void serve(int inFd, int outFd) {
+        Connection connection{inFd, std::string(), std::string(), false};
+
+        while (true) {
+            ssize_t received = read(inFd, chunk.data(), chunk.size());
+            if (received < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error(std::string("read failed: ") + strerror(errno));
+            }
+            if (received == 0) break;
+
+            // Everything that arrived in one read is answered with one write
+            receive(connection, chunk.data(), static_cast<size_t>(received));
+            if (!connection.outbox.empty()) {
+                writeAll(outFd, connection.outbox.data(), connection.outbox.size());
+                connection.outbox.clear();
+            }
+            if (connection.closing) break;
+        }
+
+        if (reportMemory) {
+            printMemoryReport(std::cerr, nullptr);
+        }
+    }
+
+    // Accepts connections on a Unix-domain socket and serves all of them at
+    // once with poll(), so one idle client cannot hold up the others
+    void listenUnix(const std::string& path) {
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("Socket path too long: " + path);
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+        // Only replace a stale socket: never a regular file that happens to be
+        // there, and never a socket another server still accepts connections on
+        struct stat existing;
+        if (lstat(path.c_str(), &existing) == 0) {
+            if (!S_ISSOCK(existing.st_mode)) {
+                throw std::runtime_error("Refusing to replace " + path + ": not a socket");
+            }
+
+            int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (probe < 0) {
+                throw std::runtime_error(std::string("socket failed: ") + strerror(errno));
+            }
+            bool live = connect(probe, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+            int error = errno;
+            close(probe);
+
+            if (live) {
+                throw std::runtime_error("Refusing to replace " + path + ": a server is listening on it");
+            }
+            if (error != ECONNREFUSED) {
+                throw std::runtime_error("Cannot check " + path + ": " + strerror(error));
+            }
+            unlink(path.c_str());
+        }
+
+        int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0) {
+            throw std::runtime_error(std::string("socket failed: ") + strerror(errno));
+        }
+
+        if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+            listen(listener, 16) < 0 || !setNonBlocking(listener)) {
+            std::string message = std::string("Cannot listen on ") + path + ": " + strerror(errno);
+            close(listener);
+            throw std::runtime_error(message);
+        }
+
+        std::vector<Connection> connections;
+        std::vector<pollfd> pollSet;
+
+        while (true) {
+            pollSet.clear();
+            pollSet.push_back({listener, POLLIN, 0});
+            for (const auto& connection : connections) {
+                short events = 0;
+                if (!connection.closing && connection.outbox.size() < MAX_PENDING_OUTPUT) events |= POLLIN;
+                if (!connection.outbox.empty()) events |= POLLOUT;
+                pollSet.push_back({connection.fd, events, 0});
+            }
+
+            if (poll(pollSet.data(), pollSet.size(), -1) < 0) {
+                if (errno == EINTR) continue;
+                close(listener);
+                throw std::runtime_error(std::string("poll failed: ") + strerror(errno));
+            }
+
+            for (size_t i = 0; i < connections.size(); i++) {
+                Connection& connection = connections[i];
+                short events = pollSet[i + 1].revents;
+                bool healthy = true;
+
+                if (events & (POLLIN | POLLHUP | POLLERR)) {
+                    healthy = readFrom(connection);
+                }
+                if (healthy && !connection.outbox.empty()) {
+                    healthy = flushTo(connection);
+                }
+
+                if (!healthy || (connection.closing && connection.outbox.empty())) {
+                    close(connection.fd);
+                    connection.fd = -1;
+                    if (reportMemory) {
+                        printMemoryReport(std::cerr, nullptr);
+                    }
+                }
+            }
+
+            connections.erase(std::remove_if(connections.begin(), connections.end(),
+                                             [](const Connection& connection) { return connection.fd < 0; }),
+                              connections.end());
+
+            if (pollSet[0].revents & POLLIN) {
+                acceptClients(listener, connections);
+            }
+        }
+    }
+
+private:
+    static bool setNonBlocking(int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+
+    static void acceptClients(int listener, std::vector<Connection>& connections) {
+        while (true) {
+            int client = accept(listener, nullptr, nullptr);
+            if (client < 0) {
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    std::cerr << "Error: accept failed: " << strerror(errno) << std::endl;
+                }
+                return;
+            }
+
+            if (!setNonBlocking(client)) {
+                close(client);
+                continue;
+            }
+            connections.push_back({client, std::string(), std::string(), false});
+        }
+    }
+
+    // Reads what is available and answers complete frames; returns false if the connection failed
+    bool readFrom(Connection& connection) {
+        ssize_t received = read(connection.fd, chunk.data(), chunk.size());
+        if (received < 0) {
+            return errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        if (received == 0) {
+            // The peer is done sending; finish flushing its replies, then close
+            connection.closing = true;
+            return true;
+        }
+
+        receive(connection, chunk.data(), static_cast<size_t>(received));
+        return true;
+    }
+
+    // Buffers received bytes and answers complete frames. Running out of
+    // memory budget fails only this connection: it gets an error and is closed.
+    void receive(Connection& connection, const char* data, size_t size) {
+        try {
+            connection.inbox.append(data, size);
+            drainFrames(connection);
+        } catch (const std::bad_alloc& e) {
+            std::string().swap(connection.inbox);
+            queueResponse(connection.outbox, std::string("ERROR ") + e.what() + "\n");
+            connection.closing = true;
+        }
+    }
+
+    // Writes as much pending output as the socket accepts; returns false if the connection failed
+    static bool flushTo(Connection& connection) {
+        size_t sent = 0;
+        while (sent < connection.outbox.size()) {
+            ssize_t written = write(connection.fd, connection.outbox.data() + sent, connection.outbox.size() - sent);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                return false;
+            }
+            sent += static_cast<size_t>(written);
+        }
+
+        connection.outbox.erase(0, sent);
+        return true;
+    }
+
+    // Handles every complete frame in the inbox; an oversized frame marks the connection for closing
+    void drainFrames(Connection& connection) {
+        std::string& inbox = connection.inbox;
+        size_t offset = 0;
+
+        while (inbox.size() - offset >= 4) {
+            const unsigned char* header = reinterpret_cast<const unsigned char*>(inbox.data() + offset);
+            uint32_t length = (uint32_t(header[0]) << 24) | (uint32_t(header[1]) << 16) |
+                              (uint32_t(header[2]) << 8) | uint32_t(header[3]);
+
+            // Refused before the rest of the frame is buffered
+            bool overBudget = memoryAccounting.budget != 0 && length > memoryAccounting.budget;
+            if (length > MAX_FRAME_SIZE || overBudget) {
+                queueResponse(connection.outbox, overBudget ? "ERROR Frame exceeds memory budget\n"
+                                                            : "ERROR Frame too large\n");
+                connection.closing = true;
+                offset = inbox.size();
+                break;
+            }
+            if (inbox.size() - offset - 4 < length) {
+                // Grow once to fit the frame and one more read, rather than
+                // doubling past the budget
+                inbox.erase(0, offset);
+                offset = 0;
+                inbox.reserve(4 + length + READ_CHUNK_SIZE);
+                break;
+            }
+
+            handleRequest(inbox.data() + offset + 4, length, connection.outbox);
+            offset += 4 + length;
+        }
+
+        inbox.erase(0, offset);
+    }
+
+    void handleRequest(const char* data, size_t size, std::string& outbox) {
+        // Peaks in a memory report cover this request only, not earlier ones
+        resetMemoryPeaks();
+
+        try {
+            const char* newline = static_cast<const char*>(std::memchr(data, '\n', size));
+            std::string header = newline ? std::string(data, newline) : std::string(data, size);
+            std::string source = newline ? std::string(newline + 1, data + size) : std::string();
+
+            bool wantTokens = false, wantAst = false, wantOptimized = false, wantMemory = false;
+            std::istringstream outputs(header);
+            std::string output;
+            while (outputs >> output) {
+                if (output == "tokens") {
+                    wantTokens = true;
+                } else if (output == "ast") {
+                    wantAst = true;
+                } else if (output == "optimized") {
+                    wantOptimized = true;
+                } else if (output == "memory") {
+                    wantMemory = true;
+                } else {
+                    throw std::runtime_error("Unknown output '" + output + "'");
+                }
+            }
+
+            std::ostringstream out;
+            std::shared_ptr<ASTNode> ast;
+
+            std::vector<Token> tokens;
+            {
+                MemoryStageScope stage(STAGE_LEXER);
+                Lexer lexer(std::move(source));
+                tokens = lexer.tokenize();
+            }
+            if (wantTokens) {
+                MemoryStageScope stage(STAGE_OUTPUT);
+                out << "Tokens:\n";
+                printTokens(out, tokens);
+            }
+
+            if (wantAst || wantOptimized) {
+                {
+                    MemoryStageScope stage(STAGE_PARSER);
+                    Parser parser(std::move(tokens));
+                    ast = parser.parse();
+                }
+
+                if (wantAst) {
+                    MemoryStageScope stage(STAGE_OUTPUT);
+                    checkRenderedSize(ast);
+                    out << "Abstract Syntax Tree:\n";
+                    printAST(out, ast);
+                }
+                if (wantOptimized) {
+                    Optimizer optimizer;
+                    {
+                        MemoryStageScope stage(STAGE_OPTIMIZER);
+                        ast = optimizer.optimize(std::move(ast));
+                    }
+
+                    MemoryStageScope stage(STAGE_OUTPUT);
+                    checkRenderedSize(ast);
+                    out << "Optimized Syntax Tree (" << optimizer.eliminatedNodes() << " nodes eliminated):\n";
+                    printAST(out, ast);
+                }
+            }
+
+            if (wantMemory) {
+                printMemoryReport(out, ast);
+            }
+
+            response.assign("OK\n");
+            response += out.str();
+        } catch (const std::exception& e) {
+            response.assign("ERROR ");
+            response += e.what();
+            response += "\n";
+        }
+
+        queueResponse(outbox, response);
+    }
+
+    // printAST indents every line by its depth, so a long operator chain renders
+    // to text quadratic in its length. Such trees are refused before rendering.
+    static void checkRenderedSize(const std::shared_ptr<ASTNode>& ast) {
+        size_t bytes = 0;
+        std::vector<std::pair<const ASTNode*, size_t>> pending{{ast.get(), 0}};
+
+        while (!pending.empty()) {
+            const ASTNode* node = pending.back().first;
+            size_t level = pending.back().second;
+            pending.pop_back();
+
+            bytes += level * 2 + node->type.size() + node->value.size() + 3;
+            if (bytes > MAX_FRAME_SIZE) {
+                throw std::runtime_error("Output too large");
+            }
+            for (const auto& child : node->children) {
+                pending.emplace_back(child.get(), level + 1);
+            }
+        }
+    }
+
+    static void queueResponse(std::string& outbox, const std::string& payload) {
+        uint32_t length = static_cast<uint32_t>(payload.size());
+        char header[4] = {
+            static_cast<char>((length >> 24) & 0xff), static_cast<char>((length >> 16) & 0xff),
+            static_cast<char>((length >> 8) & 0xff), static_cast<char>(length & 0xff)
+        };
+        outbox.append(header, 4);
+        outbox += payload;
+    }
+
+    static void writeAll(int fd, const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t written = write(fd, data, size);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error(std::string("write failed: ") + strerror(errno));
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+    }
+};
+
+#ifndef MINI_COMPILER_EMBEDDED
+// Reads a whole file with one allocation sized from fstat, without stream buffers
+static bool readSourceFile(const std::string& path, std::string& source) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) < 0) {
+        int error = errno;
+        close(fd);
+        errno = error;
+        return false;
+    }
+
+    source.clear();
+    source.resize(static_cast<size_t>(info.st_size));
+
+    size_t filled = 0;
+    while (filled < source.size()) {
+        ssize_t received = read(fd, &source[filled], source.size() - filled);
+        if (received < 0) {
+            if (errno == EINTR) continue;
+            int error = errno;
+            close(fd);
+            errno = error;
+            return false;
+        }
+        if (received == 0) break;
+        filled += static_cast<size_t>(received);
+    }
+
+    source.resize(filled);
+    close(fd);
+    return true;
+}
+
+// Parses sizes such as 1048576, 512K, 64M or 1G; negative and out-of-range sizes fail
+static bool parseByteSize(const std::string& text, size_t& bytes) {
+    // strtoull accepts a sign and would turn -1 into ULLONG_MAX
+    if (text.empty() || !isdigit(static_cast<unsigned char>(text[0]))) return false;
+
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+    if (errno == ERANGE) return false;
+
+    std::string suffix(end);
+    int shift = 0;
+    if (suffix == "K" || suffix == "k") {
+        shift = 10;
+    } else if (suffix == "M" || suffix == "m") {
+        shift = 20;
+    } else if (suffix == "G" || suffix == "g") {
+        shift = 30;
+    } else if (!suffix.empty()) {
+        return false;
+    }
+
+    if (value > (static_cast<unsigned long long>(SIZE_MAX) >> shift)) return false;
+
+    bytes = static_cast<size_t>(value << shift);
+    return bytes != 0;
+}
+
+int main(int argc, char* argv[]) {
+    std::string mode;
+    std::string socketPath;
+    std::string sourcePath;
+    size_t memBudget = 0;
+    bool memReport = false;
+    bool usageError = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--server" && mode.empty()) {
+            mode = arg;
+        } else if (arg == "--socket" && mode.empty() && i + 1 < argc) {
+            mode = arg;
+            socketPath = argv[++i];
+        } else if (arg == "--mem-budget" && i + 1 < argc) {
+            if (!parseByteSize(argv[++i], memBudget)) usageError = true;
+        } else if (arg == "--mem-report") {
+            memReport = true;
+        } else if (arg[0] != '-' && sourcePath.empty()) {
+            sourcePath = arg;
+        } else {
+            usageError = true;
+        }
+    }
+
+    if (usageError || (!mode.empty() && !sourcePath.empty())) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--mem-budget <bytes>[K|M|G]] [--mem-report] [--server | --socket <path> | <source-file>]"
+                  << std::endl;
+        return 2;
+    }
+
+    // Take the probe allocation before the budget starts counting
+    astNodeAllocationSize();
+    memoryAccounting.budget = memBudget;
+
+    // Server modes: --server (stdin/stdout) or --socket <path>
+    if (!mode.empty()) {
+        try {
+            // A client hanging up mid-reply must not kill the server
+            signal(SIGPIPE, SIG_IGN);
+
+            CompilerServer server(memReport);
+            if (mode == "--server") {
+                server.serve(STDIN_FILENO, STDOUT_FILENO);
+            } else {
+                server.listenUnix(socketPath);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Under a budget, drop comments while lexing and free the tokens once parsed
+    bool lowMemory = memBudget != 0;
+    std::shared_ptr<ASTNode> ast;
+
+    try {
+        std::string source;
+        if (sourcePath.empty()) {
+            // Example usage
+            source = R"(
         int main() {
             int x = 10;
             // This is a single-line comment
@@ -724,33 +2230,83 @@ int main() {
             return 0;
         }
     )";
+        } else if (!readSourceFile(sourcePath, source)) {
+            std::cerr << "Error: Cannot read " << sourcePath << ": " << strerror(errno) << std::endl;
+            return 1;
+        }
 
-    try {
         // Create lexer and tokenize
-        Lexer lexer(source);
-        auto tokens = lexer.tokenize();
+        std::vector<Token> tokens;
+        {
+            MemoryStageScope stage(STAGE_LEXER);
+            if (lowMemory) {
+                // The lexer takes over the source rather than keeping a second copy
+                Lexer lexer(std::move(source), false);
+                tokens = lexer.tokenize();
+            } else {
+                Lexer lexer(source);
+                tokens = lexer.tokenize();
+            }
+        }
 
         // Print tokens
-        std::cout << "Tokens:\n";
-        for (const auto& token : tokens) {
-            std::cout << "Type: " << token.type 
-                      << ", Value: " << token.value 
-                      << ", Line: " << token.line 
-                      << ", Column: " << token.column << "\n";
+        {
+            MemoryStageScope stage(STAGE_OUTPUT);
+            std::cout << "Tokens:\n";
+            printTokens(std::cout, tokens);
         }
 
         // Create parser and generate AST
-        Parser parser(tokens);
-        auto ast = parser.parse();
+        {
+            MemoryStageScope stage(STAGE_PARSER);
+            if (lowMemory) {
+                Parser parser(std::move(tokens));
+                ast = parser.parse();
+            } else {
+                Parser parser(tokens);
+                ast = parser.parse();
+            }
+        }
 
         // Print AST
-        std::cout << "\nAbstract Syntax Tree:\n";
-        printAST(ast);
+        {
+            MemoryStageScope stage(STAGE_OUTPUT);
+            std::cout << "\nAbstract Syntax Tree:\n";
+            printAST(ast);
+        }
+
+        // Fold constants and drop statically dead branches
+        Optimizer optimizer;
+        {
+            MemoryStageScope stage(STAGE_OPTIMIZER);
+            ast = optimizer.optimize(std::move(ast));
+        }
+
+        {
+            MemoryStageScope stage(STAGE_OUTPUT);
+            std::cout << "\nOptimized Syntax Tree (" << optimizer.eliminatedNodes() << " nodes eliminated):\n";
+            printAST(ast);
+        }
 
+    } catch (const MemoryBudgetExceeded&) {
+        // Lift the budget so the report itself can allocate
+        memoryAccounting.budget = 0;
+        std::cout.flush();
+        std::cerr << "Error: Memory budget of " << memBudget << " bytes exceeded during "
+                  << memoryStageNames[memoryAccounting.failedStage] << std::endl;
+        printMemoryReport(std::cerr, nullptr);
+        return 1;
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
     }
 
+    if (memReport) {
+        memoryAccounting.budget = 0;
+        std::cout << "\n";
+        printMemoryReport(std::cout, ast);
+    }
+
     return 0;
-}
\ No newline at end of file
+}
+#endif // MINI_COMPILER_EMBEDDED